@@ -0,0 +1,123 @@
+#pragma once
+// Arc-length parameterization of Bezier curves of any degree: a cumulative
+// length table over uniform t, built with adaptive Gauss-Legendre quadrature,
+// O(log n) distance -> t lookup and equal-distance resampling.
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+class BezierCurve {
+public:
+    // pts: (degree+1) xyz control points; count must be at least 1
+    BezierCurve(const float* pts,int count){
+        if(count<1) throw std::invalid_argument("BezierCurve needs at least one control point");
+        P.assign(pts,pts+count*3); D.resize((count-1)*3);
+        int n=count-1;
+        for(int i=0;i<n;i++)
+            for(int k=0;k<3;k++) D[i*3+k]=n*((double)P[(i+1)*3+k]-P[i*3+k]);
+    }
+
+    int degree() const { return (int)P.size()/3-1; }
+
+    void eval(double t,float* out) const {
+        double r[3]; casteljau(P.data(),(int)P.size()/3,t,r);
+        out[0]=(float)r[0]; out[1]=(float)r[1]; out[2]=(float)r[2];
+    }
+
+    // |B'(t)|, from the hodograph control points
+    double speed(double t) const {
+        if(D.empty()) return 0.0;
+        double d[3]; casteljau(D.data(),(int)D.size()/3,t,d);
+        return sqrt(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]);
+    }
+
+private:
+    std::vector<float> P;
+    std::vector<double> D;
+
+    template<class T> static void casteljau(const T* pts,int count,double t,double* out){
+        if(count<1){ out[0]=out[1]=out[2]=0; return; }
+        // high degrees use a per-thread buffer that only grows, so speed() stays allocation-free
+        double buf[3*16]; double* w=buf;
+        if(count>16){
+            static thread_local std::vector<double> heap;
+            if(heap.size()<(size_t)count*3) heap.resize(count*3);
+            w=heap.data();
+        }
+        for(int i=0;i<count*3;i++) w[i]=pts[i];
+        double u=1.0-t;
+        for(int r=count-1;r>0;r--)
+            for(int i=0;i<r;i++)
+                for(int k=0;k<3;k++) w[i*3+k]=u*w[i*3+k]+t*w[(i+1)*3+k];
+        out[0]=w[0]; out[1]=w[1]; out[2]=w[2];
+    }
+};
+
+// 5-point Gauss-Legendre over [a,b]
+inline double gaussLegendre5(const BezierCurve& c,double a,double b){
+    static const double x[5]={0.0,-0.5384693101056831,0.5384693101056831,-0.9061798459386640,0.9061798459386640};
+    static const double w[5]={0.5688888888888889,0.4786286704993665,0.4786286704993665,0.2369268850561891,0.2369268850561891};
+    double h=0.5*(b-a), m=0.5*(a+b), s=0;
+    for(int i=0;i<5;i++) s+=w[i]*c.speed(m+h*x[i]);
+    return s*h;
+}
+
+// Splits until the halves agree with the whole to within tol (per unit of t).
+inline double adaptiveLength(const BezierCurve& c,double a,double b,double whole,double tol,int depth=0){
+    double m=0.5*(a+b), l=gaussLegendre5(c,a,m), r=gaussLegendre5(c,m,b);
+    if(depth>=20 || fabs(l+r-whole)<=tol*(b-a)) return l+r;
+    return adaptiveLength(c,a,m,l,tol,depth+1)+adaptiveLength(c,m,b,r,tol,depth+1);
+}
+
+class ArcLengthTable {
+public:
+    // len[i] is the arc length from t=0 to t=i/segments. `curve` must outlive the table.
+    void build(const BezierCurve& curve,int segments,double tol=1e-9){
+        if(segments<1) throw std::invalid_argument("ArcLengthTable needs at least one segment");
+        c=&curve; n=segments;
+        len.resize(n+1); len[0]=0.0;
+        for(int i=0;i<n;i++){
+            double a=i/(double)n, b=(i+1)/(double)n;
+            len[i+1]=len[i]+adaptiveLength(curve,a,b,gaussLegendre5(curve,a,b),tol);
+        }
+    }
+
+    double length() const { return len.empty()?0.0:len.back(); }
+
+    // Parameter t at arc length s: binary search for the segment, linear
+    // interpolation inside it, then `newton` refinement steps against |B'|.
+    // A NaN distance is invalid input and yields NaN.
+    double tAtLength(double s,int newton=1) const {
+        if(s!=s) return std::numeric_limits<double>::quiet_NaN();
+        if(s<=0) return 0.0;
+        if(s>=length()) return 1.0;
+        int i=(int)(std::upper_bound(len.begin(),len.end(),s)-len.begin())-1;
+        double a=i/(double)n, seg=len[i+1]-len[i];
+        double t=a+(seg>0?(s-len[i])/seg:0.0)/n;
+        for(int k=0;k<newton;k++){
+            double sp=c->speed(t);
+            if(sp<=0) break;
+            t-=(len[i]+gaussLegendre5(*c,a,t)-s)/sp;
+            t=std::min((i+1)/(double)n,std::max(a,t));
+        }
+        return t;
+    }
+
+    // count+1 points equally spaced in arc length, appended as xyz
+    void resample(int count,std::vector<float>& out) const {
+        if(count<=0 || !c) return;
+        for(int i=0;i<=count;i++){
+            float p[3]; c->eval(tAtLength(length()*i/count),p);
+            out.push_back(p[0]); out.push_back(p[1]); out.push_back(p[2]);
+        }
+    }
+
+    size_t bytes() const { return len.size()*sizeof(double); }
+
+private:
+    const BezierCurve* c=0;
+    int n=0;
+    std::vector<double> len;
+};
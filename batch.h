@@ -0,0 +1,111 @@
+#pragma once
+// Batch tessellation jobs: CSV manifest parsing and a single-file output store.
+//
+// Manifest, one job per line ('#' starts a comment):
+//   id,cylinder,radius,height,slices
+//   id,cone,radius,height,slices
+//   id,sphere,radius,stacks,slices
+//   id,torus,R,r,ns,nt
+//   id,bezier_curve,segments[,12 control point coords]
+//   id,bezier_surface,res[,48 control point coords]
+//
+// Store: <out>.bin holds each mesh as float32 xyz vertices followed by uint32
+// indices; <out>.idx lists id,type,offset,vertices,indices per job.
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+struct BatchJob {
+    std::string id, type;
+    std::vector<double> args;
+};
+
+inline bool parseManifest(const char* path,std::vector<BatchJob>& jobs){
+    FILE* f=fopen(path,"r");
+    if(!f){ fprintf(stderr,"cannot open manifest %s\n",path); return false; }
+    char line[4096]; int lineNo=0;
+    while(fgets(line,sizeof(line),f)){
+        lineNo++;
+        char* hash=strchr(line,'#'); if(hash) *hash=0;
+        line[strcspn(line,"\r\n")]=0;
+        if(!line[strspn(line," \t")]) continue;
+        // split on every comma so an empty field is an error rather than a shifted one
+        BatchJob job; int field=0;
+        for(char* tok=line; tok; field++){
+            char* comma=strchr(tok,','); if(comma) *comma=0;
+            while(*tok==' '||*tok=='\t') tok++;
+            char* last=tok+strlen(tok);
+            while(last>tok && (last[-1]==' '||last[-1]=='\t')) *--last=0;
+            if(!*tok){ fprintf(stderr,"%s:%d: empty field %d\n",path,lineNo,field+1); fclose(f); return false; }
+            if(field==0) job.id=tok;
+            else if(field==1) job.type=tok;
+            else {
+                char* end; double v=strtod(tok,&end);
+                if(end==tok || *end){ fprintf(stderr,"%s:%d: bad number '%s'\n",path,lineNo,tok); fclose(f); return false; }
+                job.args.push_back(v);
+            }
+            tok=comma?comma+1:0;
+        }
+        jobs.push_back(job);
+    }
+    fclose(f);
+    return true;
+}
+
+// Appends meshes from any thread; records are in completion order. The first
+// I/O error marks the store failed and later writes are dropped, so .idx never
+// points past what actually reached .bin.
+class MeshStore {
+public:
+    bool open(const char* prefix){
+        std::string p(prefix);
+        bin=fopen((p+".bin").c_str(),"wb"); idx=fopen((p+".idx").c_str(),"w");
+        if(!bin || !idx){ fprintf(stderr,"cannot create %s.bin/.idx\n",prefix); close(); return false; }
+        offset=0; failed=false;
+        if(fprintf(idx,"id,type,offset,vertices,indices\n")<0){ fprintf(stderr,"cannot write %s.idx\n",prefix); close(); return false; }
+        return true;
+    }
+
+    bool write(const BatchJob& job,const std::vector<float>& verts,const std::vector<unsigned int>& indices){
+        std::lock_guard<std::mutex> lock(m);
+        if(failed) return false;
+        if(fwrite(verts.data(),sizeof(float),verts.size(),bin)!=verts.size() ||
+           fwrite(indices.data(),sizeof(unsigned int),indices.size(),bin)!=indices.size() ||
+           fprintf(idx,"%s,%s,%llu,%zu,%zu\n",job.id.c_str(),job.type.c_str(),(unsigned long long)offset,verts.size()/3,indices.size())<0){
+            failed=true; return false;
+        }
+        offset+=verts.size()*sizeof(float)+indices.size()*sizeof(unsigned int);
+        return true;
+    }
+
+    // false if any write, flush or close failed
+    bool close(){
+        FILE* fs[2]={bin,idx};
+        for(int i=0;i<2;i++){
+            if(!fs[i]) continue;
+            if(ferror(fs[i])) failed=true;
+            if(fclose(fs[i])!=0) failed=true;
+        }
+        bin=idx=0;
+        return !failed;
+    }
+
+    unsigned long long bytes() const { return offset; }
+
+private:
+    FILE* bin=0; FILE* idx=0;
+    unsigned long long offset=0;
+    bool failed=false;
+    std::mutex m;
+};
+
+// p in [0,1] over an ascending-sorted sample
+inline double percentile(const std::vector<double>& sorted,double p){
+    if(sorted.empty()) return 0;
+    size_t i=(size_t)(p*(sorted.size()-1)+0.5);
+    return sorted[std::min(i,sorted.size()-1)];
+}
@@ -0,0 +1,201 @@
+#pragma once
+// Generators specialized on a fixed resolution. Angle tables, Bernstein tables and
+// index buffers are built at compile time; only radius/height/control points are
+// applied per call. Output layout matches genCylinder/genCone/... in main.cpp.
+#include <vector>
+
+namespace fixedgen {
+
+constexpr double PI_D = 3.14159265358979323846;
+
+// constexpr sin/cos: reduce to [-pi,pi], then Taylor series
+constexpr double csin(double x){
+    while(x> PI_D) x-=2*PI_D;
+    while(x<-PI_D) x+=2*PI_D;
+    double term=x, sum=x;
+    for(int n=1;n<14;n++){ term*=-x*x/((2*n)*(2*n+1)); sum+=term; }
+    return sum;
+}
+constexpr double ccos(double x){ return csin(x+PI_D*0.5); }
+
+// cos/sin of a*i/N for i=0..N
+template<int N> struct AngleTable {
+    float c[N+1], s[N+1];
+    constexpr AngleTable(double a): c(), s() {
+        for(int i=0;i<=N;i++){ c[i]=(float)ccos(a*i/N); s[i]=(float)csin(a*i/N); }
+    }
+};
+
+// cubic Bernstein weights at t=i/N
+template<int N> struct BernsteinTable {
+    float b[N+1][4];
+    constexpr BernsteinTable(): b() {
+        for(int i=0;i<=N;i++){
+            float t=i/(float)N, u=1.0f-t;
+            b[i][0]=u*u*u; b[i][1]=3.0f*u*u*t; b[i][2]=3.0f*u*t*t; b[i][3]=t*t*t;
+        }
+    }
+};
+
+// Index buffers as constexpr-constructed C arrays (C++14: std::array::operator[] is not constexpr there)
+template<int Slices> struct CylinderIndices {
+    enum { COUNT=Slices*12 };
+    unsigned int v[COUNT];
+    constexpr CylinderIndices(): v() {
+        int k=0;
+        for(int i=0;i<Slices;i++){
+            unsigned int p0=i*2,p1=p0+1,p2=p0+2,p3=p0+3;
+            v[k++]=p0; v[k++]=p1; v[k++]=p2; v[k++]=p1; v[k++]=p3; v[k++]=p2;
+        }
+        unsigned int bottom=(Slices+1)*2, top=bottom+1;
+        for(int i=0;i<Slices;i++){ v[k++]=bottom; v[k++]=((i+1)%Slices)*2; v[k++]=i*2; }
+        for(int i=0;i<Slices;i++){ v[k++]=top; v[k++]=i*2+1; v[k++]=((i+1)%Slices)*2+1; }
+    }
+};
+
+template<int Slices> struct ConeIndices {
+    enum { COUNT=Slices*6 };
+    unsigned int v[COUNT];
+    constexpr ConeIndices(): v() {
+        int k=0;
+        for(int i=0;i<Slices;i++){ v[k++]=0; v[k++]=i+1; v[k++]=i+2; }
+        unsigned int base=Slices+2;
+        for(int i=0;i<Slices;i++){ v[k++]=base; v[k++]=((i+1)%Slices)+1; v[k++]=i+1; }
+    }
+};
+
+// (Rows x Cols) quads over a (Rows+1) x (Cols+1) vertex grid
+template<int Rows,int Cols> struct GridIndices {
+    enum { COUNT=Rows*Cols*6 };
+    unsigned int v[COUNT];
+    constexpr GridIndices(): v() {
+        int k=0;
+        for(int i=0;i<Rows;i++)
+            for(int j=0;j<Cols;j++){
+                unsigned int a=i*(Cols+1)+j,b=a+(Cols+1);
+                v[k++]=a; v[k++]=b; v[k++]=a+1; v[k++]=a+1; v[k++]=b; v[k++]=b+1;
+            }
+    }
+};
+
+template<int Slices> struct Cylinder {
+    static constexpr AngleTable<Slices> ang{2*PI_D};
+    static constexpr CylinderIndices<Slices> idx{};
+};
+template<int Slices> struct Cone {
+    static constexpr AngleTable<Slices> ang{2*PI_D};
+    static constexpr ConeIndices<Slices> idx{};
+};
+template<int Stacks,int Slices> struct Sphere {
+    static constexpr AngleTable<Stacks> phi{PI_D};
+    static constexpr AngleTable<Slices> theta{2*PI_D};
+    static constexpr GridIndices<Stacks,Slices> idx{};
+};
+template<int NS,int NT> struct Torus {
+    static constexpr AngleTable<NS> u{2*PI_D};
+    static constexpr AngleTable<NT> v{2*PI_D};
+    static constexpr GridIndices<NS,NT> idx{};
+};
+template<int Res> struct Bezier {
+    static constexpr BernsteinTable<Res> basis{};
+};
+template<int Res> struct Patch {
+    static constexpr GridIndices<Res,Res> idx{};
+};
+
+// out-of-class definitions: the tables are ODR-used and C++14 has no inline variables
+template<int Slices> constexpr AngleTable<Slices> Cylinder<Slices>::ang;
+template<int Slices> constexpr CylinderIndices<Slices> Cylinder<Slices>::idx;
+template<int Slices> constexpr AngleTable<Slices> Cone<Slices>::ang;
+template<int Slices> constexpr ConeIndices<Slices> Cone<Slices>::idx;
+template<int Stacks,int Slices> constexpr AngleTable<Stacks> Sphere<Stacks,Slices>::phi;
+template<int Stacks,int Slices> constexpr AngleTable<Slices> Sphere<Stacks,Slices>::theta;
+template<int Stacks,int Slices> constexpr GridIndices<Stacks,Slices> Sphere<Stacks,Slices>::idx;
+template<int NS,int NT> constexpr AngleTable<NS> Torus<NS,NT>::u;
+template<int NS,int NT> constexpr AngleTable<NT> Torus<NS,NT>::v;
+template<int NS,int NT> constexpr GridIndices<NS,NT> Torus<NS,NT>::idx;
+template<int Res> constexpr BernsteinTable<Res> Bezier<Res>::basis;
+template<int Res> constexpr GridIndices<Res,Res> Patch<Res>::idx;
+
+template<class Table> inline void copyIndices(const Table& src,std::vector<unsigned int>& idx){
+    idx.assign(src.v,src.v+Table::COUNT);
+}
+
+template<int Slices> void cylinder(float radius,float height,std::vector<float>& v,std::vector<unsigned int>& idx){
+    typedef Cylinder<Slices> T;
+    float half=height*0.5f;
+    v.resize(((Slices+1)*2+2)*3);
+    float* p=v.data();
+    for(int i=0;i<=Slices;i++){
+        float x=radius*T::ang.c[i], y=radius*T::ang.s[i];
+        *p++=x; *p++=y; *p++=-half;
+        *p++=x; *p++=y; *p++= half;
+    }
+    *p++=0; *p++=0; *p++=-half;
+    *p++=0; *p++=0; *p++= half;
+    copyIndices(T::idx,idx);
+}
+
+template<int Slices> void cone(float radius,float height,std::vector<float>& v,std::vector<unsigned int>& idx){
+    typedef Cone<Slices> T;
+    float half=height*0.5f;
+    v.resize((Slices+3)*3);
+    float* p=v.data();
+    *p++=0; *p++=0; *p++=half;
+    for(int i=0;i<=Slices;i++){ *p++=radius*T::ang.c[i]; *p++=radius*T::ang.s[i]; *p++=-half; }
+    *p++=0; *p++=0; *p++=-half;
+    copyIndices(T::idx,idx);
+}
+
+template<int Stacks,int Slices> void sphere(float R,std::vector<float>& v,std::vector<unsigned int>& idx){
+    typedef Sphere<Stacks,Slices> T;
+    v.resize((Stacks+1)*(Slices+1)*3);
+    float* p=v.data();
+    for(int i=0;i<=Stacks;i++){
+        float z=R*T::phi.c[i], r=R*T::phi.s[i];
+        for(int j=0;j<=Slices;j++){ *p++=r*T::theta.c[j]; *p++=r*T::theta.s[j]; *p++=z; }
+    }
+    copyIndices(T::idx,idx);
+}
+
+template<int NS,int NT> void torus(float R,float r,std::vector<float>& v,std::vector<unsigned int>& idx){
+    typedef Torus<NS,NT> T;
+    v.resize((NS+1)*(NT+1)*3);
+    float* p=v.data();
+    for(int i=0;i<=NS;i++)
+        for(int j=0;j<=NT;j++){
+            float ring=R+r*T::v.c[j];
+            *p++=ring*T::u.c[i]; *p++=ring*T::u.s[i]; *p++=r*T::v.s[j];
+        }
+    copyIndices(T::idx,idx);
+}
+
+// Collapses the 4x4 patch along u once per row, then evaluates 4 points per vertex.
+template<int Res> void bezierSurface(const float P[4][4][3],std::vector<float>& v,std::vector<unsigned int>& idx){
+    typedef Bezier<Res> B;
+    v.resize((Res+1)*(Res+1)*3);
+    float* p=v.data();
+    for(int iu=0;iu<=Res;iu++){
+        const float* bu=B::basis.b[iu];
+        float Q[4][3];
+        for(int j=0;j<4;j++)
+            for(int k=0;k<3;k++) Q[j][k]=bu[0]*P[0][j][k]+bu[1]*P[1][j][k]+bu[2]*P[2][j][k]+bu[3]*P[3][j][k];
+        for(int iv=0;iv<=Res;iv++){
+            const float* bv=B::basis.b[iv];
+            for(int k=0;k<3;k++) *p++=bv[0]*Q[0][k]+bv[1]*Q[1][k]+bv[2]*Q[2][k]+bv[3]*Q[3][k];
+        }
+    }
+    copyIndices(Patch<Res>::idx,idx);
+}
+
+template<int Segments> void bezierCurve(const float P[4][3],std::vector<float>& curve){
+    typedef Bezier<Segments> T;
+    curve.resize((Segments+1)*3);
+    float* p=curve.data();
+    for(int i=0;i<=Segments;i++){
+        const float* b=T::basis.b[i];
+        for(int k=0;k<3;k++) *p++=b[0]*P[0][k]+b[1]*P[1][k]+b[2]*P[2][k]+b[3]*P[3][k];
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+// Offscreen GL context for batch rendering without a window: EGL on Mesa's
+// surfaceless platform (llvmpipe when no GPU), pbuffer surface, compatibility
+// profile so the fixed-function drawing in main.cpp runs unchanged.
+// Opt-in: build with -DLAB_HEADLESS and link -lEGL; the viewer alone needs neither.
+#ifdef LAB_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+struct HeadlessGL {
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    EGLSurface surf = EGL_NO_SURFACE;
+    EGLContext ctx = EGL_NO_CONTEXT;
+    int width = 0, height = 0;
+
+    bool init(int w,int h){
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if(getPlatformDisplay) dpy=getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,EGL_DEFAULT_DISPLAY,0);
+        if(dpy==EGL_NO_DISPLAY) dpy=eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        EGLint major,minor;
+        if(dpy==EGL_NO_DISPLAY || !eglInitialize(dpy,&major,&minor)){
+            fprintf(stderr,"headless: no EGL display (0x%x)\n",eglGetError());
+            dpy=EGL_NO_DISPLAY; return false;
+        }
+
+        EGLint cfgAttr[]={ EGL_SURFACE_TYPE,EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE,EGL_OPENGL_BIT,
+                           EGL_RED_SIZE,8, EGL_GREEN_SIZE,8, EGL_BLUE_SIZE,8, EGL_DEPTH_SIZE,24, EGL_NONE };
+        EGLConfig cfg; EGLint n=0;
+        if(!eglChooseConfig(dpy,cfgAttr,&cfg,1,&n) || n==0){ fprintf(stderr,"headless: no pbuffer config\n"); shutdown(); return false; }
+        EGLint pbAttr[]={ EGL_WIDTH,w, EGL_HEIGHT,h, EGL_NONE };
+        surf=eglCreatePbufferSurface(dpy,cfg,pbAttr);
+        if(!eglBindAPI(EGL_OPENGL_API)){ fprintf(stderr,"headless: desktop GL not available\n"); shutdown(); return false; }
+        ctx=eglCreateContext(dpy,cfg,EGL_NO_CONTEXT,0);
+        if(surf==EGL_NO_SURFACE || ctx==EGL_NO_CONTEXT || !eglMakeCurrent(dpy,surf,surf,ctx)){
+            fprintf(stderr,"headless: context creation failed (0x%x)\n",eglGetError());
+            shutdown(); return false;
+        }
+        width=w; height=h;
+        return true;
+    }
+
+    void shutdown(){
+        if(dpy==EGL_NO_DISPLAY) return;
+        eglMakeCurrent(dpy,EGL_NO_SURFACE,EGL_NO_SURFACE,EGL_NO_CONTEXT);
+        if(ctx!=EGL_NO_CONTEXT) eglDestroyContext(dpy,ctx);
+        if(surf!=EGL_NO_SURFACE) eglDestroySurface(dpy,surf);
+        eglTerminate(dpy);
+        dpy=EGL_NO_DISPLAY; ctx=EGL_NO_CONTEXT; surf=EGL_NO_SURFACE;
+    }
+
+    // Reads the back buffer top-down as RGB.
+    void readPixels(std::vector<unsigned char>& rgb) const {
+        std::vector<unsigned char> tmp(width*height*3);
+        rgb.resize(tmp.size());
+        glPixelStorei(GL_PACK_ALIGNMENT,1);
+        glReadPixels(0,0,width,height,GL_RGB,GL_UNSIGNED_BYTE,tmp.data());
+        for(int y=0;y<height;y++)
+            std::copy(&tmp[(height-1-y)*width*3],&tmp[(height-y)*width*3],&rgb[y*width*3]);
+    }
+};
+
+inline bool writePPM(const char* path,int w,int h,const std::vector<unsigned char>& rgb){
+    FILE* f=fopen(path,"wb");
+    if(!f){ fprintf(stderr,"cannot write %s\n",path); return false; }
+    fprintf(f,"P6\n%d %d\n255\n",w,h);
+    fwrite(rgb.data(),1,rgb.size(),f);
+    fclose(f);
+    return true;
+}
+#endif
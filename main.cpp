@@ -2,6 +2,17 @@
 #include <vector>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include "raycast.h"
+#include "fixedgen.h"
+#include "quantize.h"
+#include "headless.h"
+#include "batch.h"
+#include "arclength.h"
 
 const float PI = 3.14159265358979323846f;
 
@@ -14,45 +25,73 @@ bool mouseLeftDown = false;
 int lastMouseX = 0, lastMouseY = 0;
 float camDist = 5.0f;
 
-std::vector<float> g_vertices;            
-std::vector<unsigned int> g_indices;      
-std::vector<float> g_curve;               
-int sphereStacks = 30, sphereSlices = 30;
-
-float bezP[4][3] = {
+// Generator state is per thread so --batch workers can tessellate concurrently;
+// the viewer only ever touches the main thread's copy.
+thread_local std::vector<float> g_vertices;            
+thread_local std::vector<unsigned int> g_indices;      
+thread_local std::vector<float> g_curve;               
+// Object parameters, shared by the runtime and fixedgen paths and by --bench-fixed.
+const float cylRadius = 1.0f, cylHeight = 2.0f; const int cylSlices = 48;
+const float coneRadius = 1.0f, coneHeight = 2.0f; const int coneSlices = 48;
+const float sphereRadius = 1.0f; const int sphereStacks = 30, sphereSlices = 30;
+const float torusR = 1.5f, torusr = 0.4f; const int torusNS = 48, torusNT = 32;
+const int curveSegments = 200, surfRes = 50;
+
+const float bezDefault[4][3] = {
     {-1.0f, 0.0f, 0.0f},
     {-0.5f, 1.0f, 0.0f},
     {0.5f, -1.0f, 0.0f},
     {1.0f, 0.0f, 0.0f}
 };
+thread_local float bezP[4][3];   // set by prepareCurveControl()
+
+thread_local float surfP[4][4][3];
+
+bool arcLengthSampling = false;   // curve points equally spaced in distance instead of t
+bool compactVerts = false;   // generators emit only g_packed (no g_vertices); drawMesh renders from it
+thread_local PackedMesh g_packed;
 
-float surfP[4][4][3];
+TriBVH g_bvh;
+PointIndex g_ctrlIdx;
+GLdouble g_model[16], g_proj[16]; GLint g_view[4];
+int pickedCtrl = -1; bool pickedHit = false; float pickedPos[3];
 
-inline void clearMesh(){ g_vertices.clear(); g_indices.clear(); g_curve.clear(); }
+inline void clearMesh(){ g_vertices.clear(); g_indices.clear(); g_curve.clear(); g_packed.v.clear(); }
 inline void addVertex(float x,float y,float z){ g_vertices.push_back(x); g_vertices.push_back(y); g_vertices.push_back(z); }
+inline void addPacked(float x,float y,float z,float nx,float ny,float nz,float u,float v){ g_packed.add(x,y,z,nx,ny,nz,u,v); }
+inline unsigned int vertexCount(){ return compactVerts ? (unsigned int)g_packed.v.size() : (unsigned int)(g_vertices.size()/3); }
+inline void packBounds(float x0,float y0,float z0,float x1,float y1,float z1){
+    float lo[3]={x0,y0,z0}, hi[3]={x1,y1,z1};
+    if(compactVerts) g_packed.begin(lo,hi);
+}
 inline void addTri(unsigned int a,unsigned int b,unsigned int c){ g_indices.push_back(a); g_indices.push_back(b); g_indices.push_back(c); }
 
 // --- Cylinder ---
 void genCylinder(float radius, float height, int slices){
     clearMesh();
     float half = height*0.5f;
+    packBounds(-radius,-radius,-half, radius,radius,half);
     for(int i=0;i<=slices;i++){
         float a = 2.0f*PI*i / slices;
         float x = radius * cosf(a);
         float y = radius * sinf(a);
-        addVertex(x,y,-half); 
-        addVertex(x,y, half); 
+        if(!compactVerts){ addVertex(x,y,-half); addVertex(x,y, half); continue; }
+        float c=cosf(a), s=sinf(a), u=i/(float)slices;
+        addPacked(x,y,-half, c,s,0, u,0);
+        addPacked(x,y, half, c,s,0, u,1);
     }
     for(int i=0;i<slices;i++){
         unsigned int p0=i*2,p1=p0+1,p2=p0+2,p3=p0+3;
         addTri(p0,p1,p2); addTri(p1,p3,p2);
     }
-    unsigned int bottomCenter = g_vertices.size()/3; addVertex(0,0,-half);
+    unsigned int bottomCenter = vertexCount();
+    if(compactVerts) addPacked(0,0,-half, 0,0,-1, 0.5f,0); else addVertex(0,0,-half);
     for(int i=0;i<slices;i++){
         unsigned int v=i*2,vnext=((i+1)%slices)*2;
         addTri(bottomCenter,vnext,v);
     }
-    unsigned int topCenter = g_vertices.size()/3; addVertex(0,0,half);
+    unsigned int topCenter = vertexCount();
+    if(compactVerts) addPacked(0,0,half, 0,0,1, 0.5f,1); else addVertex(0,0,half);
     for(int i=0;i<slices;i++){
         unsigned int v=i*2+1,vnext=((i+1)%slices)*2+1;
         addTri(topCenter,v,vnext);
@@ -62,13 +101,17 @@ void genCylinder(float radius, float height, int slices){
 void genCone(float radius, float height, int slices){
     clearMesh();
     float half = height*0.5f;
-    addVertex(0,0,half); 
+    packBounds(-radius,-radius,-half, radius,radius,half);
+    if(compactVerts) addPacked(0,0,half, 0,0,1, 0.5f,1); else addVertex(0,0,half); 
     for(int i=0;i<=slices;i++){
         float a=2.0f*PI*i/slices;
-        addVertex(radius*cosf(a), radius*sinf(a), -half);
+        if(!compactVerts){ addVertex(radius*cosf(a), radius*sinf(a), -half); continue; }
+        float c=cosf(a), s=sinf(a);
+        addPacked(radius*c, radius*s, -half, height*c,height*s,radius, i/(float)slices,0);
     }
     for(int i=0;i<slices;i++) addTri(0,i+1,i+2);
-    unsigned int baseCenter=g_vertices.size()/3; addVertex(0,0,-half);
+    unsigned int baseCenter=vertexCount();
+    if(compactVerts) addPacked(0,0,-half, 0,0,-1, 0.5f,0); else addVertex(0,0,-half);
     for(int i=0;i<slices;i++){
         unsigned int v=i+1,vnext=((i+1)%slices)+1;
         addTri(baseCenter,vnext,v);
@@ -77,6 +120,7 @@ void genCone(float radius, float height, int slices){
 
 void genSphere(float R,int stacks,int slices){
     clearMesh();
+    packBounds(-R,-R,-R, R,R,R);
     for(int i=0;i<=stacks;i++){
         float phi=PI*i/stacks;
         float z=R*cosf(phi);
@@ -84,7 +128,8 @@ void genSphere(float R,int stacks,int slices){
         for(int j=0;j<=slices;j++){
             float theta=2.0f*PI*j/slices;
             float x=r*cosf(theta); float y=r*sinf(theta);
-            addVertex(x,y,z);
+            if(compactVerts) addPacked(x,y,z, x,y,z, j/(float)slices,i/(float)stacks);
+            else addVertex(x,y,z);
         }
     }
     for(int i=0;i<stacks;i++)
@@ -96,12 +141,14 @@ void genSphere(float R,int stacks,int slices){
 
 void genTorus(float R,float r,int ns,int nt){
     clearMesh();
+    packBounds(-(R+r),-(R+r),-r, R+r,R+r,r);
     for(int i=0;i<=ns;i++){
         float u=2.0f*PI*i/ns; float cu=cosf(u),su=sinf(u);
         for(int j=0;j<=nt;j++){
             float v=2.0f*PI*j/nt; float cv=cosf(v),sv=sinf(v);
             float x=(R+r*cv)*cu; float y=(R+r*cv)*su; float z=r*sv;
-            addVertex(x,y,z);
+            if(compactVerts) addPacked(x,y,z, cv*cu,cv*su,sv, i/(float)ns,j/(float)nt);
+            else addVertex(x,y,z);
         }
     }
     for(int i=0;i<ns;i++)
@@ -120,6 +167,14 @@ float cubicBernstein(int i,float t){
     return t*t*t;
 }
 
+float cubicBernsteinDeriv(int i,float t){
+    float u=1.0f-t;
+    if(i==0) return -3.0f*u*u;
+    if(i==1) return 3.0f*u*u-6.0f*u*t;
+    if(i==2) return 6.0f*u*t-3.0f*t*t;
+    return 3.0f*t*t;
+}
+
 void genBezierCurve(int segments=100){
     g_curve.clear();
     for(int i=0;i<=segments;i++){
@@ -132,6 +187,15 @@ void genBezierCurve(int segments=100){
     }
 }
 
+void genBezierCurveArcLength(int segments=100){
+    g_curve.clear();
+    BezierCurve c(&bezP[0][0],4);
+    ArcLengthTable table; table.build(c,segments*4);
+    table.resample(segments,g_curve);
+}
+
+void prepareCurveControl(){ memcpy(bezP,bezDefault,sizeof(bezP)); }
+
 void prepareSurfControl(){
     for(int i=0;i<4;i++)
         for(int j=0;j<4;j++){
@@ -143,6 +207,12 @@ void prepareSurfControl(){
 
 void genBezierSurface(int res=30){
     clearMesh();
+    if(compactVerts){
+        // control net bounds enclose the patch (convex hull property)
+        float lo[3]={1e30f,1e30f,1e30f}, hi[3]={-1e30f,-1e30f,-1e30f};
+        for(int i=0;i<4;i++) for(int j=0;j<4;j++) for(int k=0;k<3;k++){ lo[k]=std::min(lo[k],surfP[i][j][k]); hi[k]=std::max(hi[k],surfP[i][j][k]); }
+        g_packed.begin(lo,hi);
+    }
     for(int iu=0;iu<=res;iu++){
         float u=iu/(float)res;
         for(int iv=0;iv<=res;iv++){
@@ -157,7 +227,15 @@ void genBezierSurface(int res=30){
                     pz+=surfP[i][j][2]*(bu*bv);
                 }
             }
-            addVertex(px,py,pz);
+            if(!compactVerts){ addVertex(px,py,pz); continue; }
+            float du[3]={0,0,0}, dv[3]={0,0,0};
+            for(int i=0;i<4;i++)
+                for(int j=0;j<4;j++){
+                    float wu=cubicBernsteinDeriv(i,u)*cubicBernstein(j,v), wv=cubicBernstein(i,u)*cubicBernsteinDeriv(j,v);
+                    for(int k=0;k<3;k++){ du[k]+=surfP[i][j][k]*wu; dv[k]+=surfP[i][j][k]*wv; }
+                }
+            float n[3]; cross3(n,dv,du);   // dv x du faces +y for the default net
+            addPacked(px,py,pz, n[0],n[1],n[2], u,v);
         }
     }
     for(int i=0;i<res;i++)
@@ -167,15 +245,92 @@ void genBezierSurface(int res=30){
         }
 }
 
+// --- Picking ---
+void buildPickIndex(){
+    // the curve leaves the previous mesh in g_vertices, so it gets no triangles
+    if(currentObj==OBJ_BEZIER_CURVE) g_bvh.build(std::vector<float>(),std::vector<unsigned int>());
+    else if(compactVerts){
+        // the packed path keeps no float positions; the BVH copies what it needs
+        std::vector<float> pos; g_packed.decodePositions(pos);
+        g_bvh.build(pos,g_indices);
+    }
+    else g_bvh.build(g_vertices,g_indices);
+    if(currentObj==OBJ_BEZIER_CURVE) g_ctrlIdx.build(&bezP[0][0],4);
+    else if(currentObj==OBJ_BEZIER_SURF) g_ctrlIdx.build(&surfP[0][0][0],16);
+    else g_ctrlIdx.build(0,0);
+    pickedCtrl=-1; pickedHit=false;
+}
+
+// Object-space ray through window pixel (x,y), using the matrices captured in display().
+Ray rayFromMouse(int x,int y){
+    GLdouble nx,ny,nz,fx,fy,fz, wy=g_view[3]-y-1;
+    gluUnProject(x,wy,0.0,g_model,g_proj,g_view,&nx,&ny,&nz);
+    gluUnProject(x,wy,1.0,g_model,g_proj,g_view,&fx,&fy,&fz);
+    Ray r = {{(float)nx,(float)ny,(float)nz},{(float)(fx-nx),(float)(fy-ny),(float)(fz-nz)}};
+    return r;
+}
+
+void pick(int x,int y){
+    Ray r=rayFromMouse(x,y);
+    float tc=FLT_MAX; RayHit h;
+    pickedCtrl=g_ctrlIdx.pickRay(r,0.08f,&tc);
+    pickedHit=g_bvh.intersect(r,h) && h.t<tc;
+    if(pickedHit){
+        pickedCtrl=-1;
+        for(int k=0;k<3;k++) pickedPos[k]=r.o[k]+h.t*r.d[k];
+        printf("hit tri %d at (%.3f, %.3f, %.3f)\n",h.tri,pickedPos[0],pickedPos[1],pickedPos[2]);
+    } else if(pickedCtrl>=0) printf("control point %d\n",pickedCtrl);
+    glutPostRedisplay();
+}
+
+void drawPick(){
+    glDisable(GL_LIGHTING); glDisable(GL_DEPTH_TEST);
+    glColor3f(1,1,0); glPointSize(10.0f); glBegin(GL_POINTS);
+    if(pickedHit) glVertex3fv(pickedPos);
+    if(pickedCtrl>=0){
+        const float* p = currentObj==OBJ_BEZIER_CURVE ? bezP[pickedCtrl] : &surfP[pickedCtrl/4][pickedCtrl%4][0];
+        glVertex3fv(p);
+    }
+    glEnd();
+    glEnable(GL_DEPTH_TEST);
+}
+
+void printCompactStats(){
+    if(g_packed.v.empty()) return;
+    size_t n=g_packed.v.size(), floatBytes=g_vertices.size()*sizeof(float);
+    printf("compact: %zu verts, holding %.1f B/vertex (packed %zu + float xyz %.1f; float mode holds 12, xyz only), pos err %.2g, normal err %.3g deg, uv err %.2g\n",
+        n,(g_packed.bytes()+floatBytes)/(double)n,sizeof(PackedVertex),floatBytes/(double)n,
+        g_packed.maxPosErr,g_packed.maxNrmErrDeg,g_packed.maxUvErr);
+}
+
 void generateObject(){
+    // only the runtime generators emit the compact layout
     switch(currentObj){
-        case OBJ_CYLINDER: genCylinder(1.0f,2.0f,48); break;
-        case OBJ_CONE: genCone(1.0f,2.0f,48); break;
-        case OBJ_SPHERE: genSphere(1.0f,sphereStacks,sphereSlices); break;
-        case OBJ_TORUS: genTorus(1.5f,0.4f,48,32); break;
-        case OBJ_BEZIER_CURVE: genBezierCurve(200); break;
-        case OBJ_BEZIER_SURF: prepareSurfControl(); genBezierSurface(50); break;
+        case OBJ_CYLINDER:
+            if(compactVerts) genCylinder(cylRadius,cylHeight,cylSlices);
+            else { clearMesh(); fixedgen::cylinder<cylSlices>(cylRadius,cylHeight,g_vertices,g_indices); }
+            break;
+        case OBJ_CONE:
+            if(compactVerts) genCone(coneRadius,coneHeight,coneSlices);
+            else { clearMesh(); fixedgen::cone<coneSlices>(coneRadius,coneHeight,g_vertices,g_indices); }
+            break;
+        case OBJ_SPHERE: genSphere(sphereRadius,sphereStacks,sphereSlices); break;
+        case OBJ_TORUS:
+            if(compactVerts) genTorus(torusR,torusr,torusNS,torusNT);
+            else { clearMesh(); fixedgen::torus<torusNS,torusNT>(torusR,torusr,g_vertices,g_indices); }
+            break;
+        case OBJ_BEZIER_CURVE:
+            prepareCurveControl();
+            if(arcLengthSampling) genBezierCurveArcLength(curveSegments); else fixedgen::bezierCurve<curveSegments>(bezP,g_curve);
+            break;
+        case OBJ_BEZIER_SURF:
+            prepareSurfControl();
+            if(compactVerts) genBezierSurface(surfRes);
+            else { clearMesh(); fixedgen::bezierSurface<surfRes>(surfP,g_vertices,g_indices); }
+            break;
     }
+    if(compactVerts && currentObj!=OBJ_BEZIER_CURVE) printCompactStats();
+    buildPickIndex();
 }
 
 // --- Drawing ---
@@ -188,6 +343,26 @@ void drawAxis(){
     glEnd();
 }
 
+// Short vertex arrays straight from g_packed; the bounds and UV scale/offset go on the matrices.
+void drawPacked(){
+    const PackedVertex* v=g_packed.v.data();
+    const float q=1.0f/32767.0f;
+    glPushMatrix();
+    glTranslatef(g_packed.center[0],g_packed.center[1],g_packed.center[2]);
+    glScalef(g_packed.half[0]*q,g_packed.half[1]*q,g_packed.half[2]*q);
+    glMatrixMode(GL_TEXTURE); glPushMatrix(); glLoadIdentity(); glTranslatef(0.5f,0.5f,0.0f); glScalef(0.5f*q,0.5f*q,1.0f); glMatrixMode(GL_MODELVIEW);
+
+    glEnableClientState(GL_VERTEX_ARRAY); glEnableClientState(GL_NORMAL_ARRAY); glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3,GL_SHORT,sizeof(PackedVertex),v->p);
+    glNormalPointer(GL_SHORT,sizeof(PackedVertex),v->n);
+    glTexCoordPointer(2,GL_SHORT,sizeof(PackedVertex),v->uv);
+    glDrawElements(GL_TRIANGLES,(GLsizei)g_indices.size(),GL_UNSIGNED_INT,g_indices.data());
+    glDisableClientState(GL_VERTEX_ARRAY); glDisableClientState(GL_NORMAL_ARRAY); glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glMatrixMode(GL_TEXTURE); glPopMatrix(); glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+}
+
 void drawMesh(){
     // --- BEZIER CURVE ---
     if(currentObj==OBJ_BEZIER_CURVE){
@@ -206,7 +381,8 @@ void drawMesh(){
     // --- BEZIER SURFACE ---
     if(currentObj==OBJ_BEZIER_SURF){
         glColor3f(0.85f,0.85f,0.85f);
-        if(!g_indices.empty()){
+        if(compactVerts && !g_packed.v.empty()) drawPacked();
+        else if(!g_indices.empty()){
             glBegin(GL_TRIANGLES);
             for(size_t i=0;i<g_indices.size();i+=3){
                 unsigned int a=g_indices[i],b=g_indices[i+1],c=g_indices[i+2];
@@ -240,6 +416,8 @@ void drawMesh(){
         glEnd(); return;
     }
 
+    if(compactVerts && !g_packed.v.empty()){ drawPacked(); return; }
+
     glBegin(GL_TRIANGLES);
     for(size_t i=0;i<g_indices.size();i+=3){
         unsigned int a=g_indices[i],b=g_indices[i+1],c=g_indices[i+2];
@@ -250,7 +428,7 @@ void drawMesh(){
     glEnd();
 }
 
-void display(){
+void renderScene(){
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
 
     glMatrixMode(GL_MODELVIEW);
@@ -272,14 +450,17 @@ void display(){
     float ambient[]={0.2f,0.2f,0.2f,1.0f}, diffuse[]={0.8f,0.8f,0.8f,1.0f};
     glLightfv(GL_LIGHT0,GL_AMBIENT,ambient); glLightfv(GL_LIGHT0,GL_DIFFUSE,diffuse);
 
+    glGetDoublev(GL_MODELVIEW_MATRIX,g_model); glGetDoublev(GL_PROJECTION_MATRIX,g_proj); glGetIntegerv(GL_VIEWPORT,g_view);
+
     drawMesh();
+    drawPick();
 
     glDisable(GL_LIGHTING);
     glPopMatrix();
-
-    glutSwapBuffers();
 }
 
+void display(){ renderScene(); glutSwapBuffers(); }
+
 void idle(){ glutPostRedisplay(); }
 void reshape(int w,int h){ glViewport(0,0,w,h); glMatrixMode(GL_PROJECTION); glLoadIdentity(); gluPerspective(45.0,(double)w/(double)h,0.1,100.0); glMatrixMode(GL_MODELVIEW); }
 
@@ -292,6 +473,8 @@ void keyboard(unsigned char key,int x,int y){
         case '5': currentObj=OBJ_BEZIER_CURVE; generateObject(); break;
         case '6': currentObj=OBJ_BEZIER_SURF; generateObject(); break;
         case 'w': case 'W': wireframe=!wireframe; break;
+        case 'c': case 'C': compactVerts=!compactVerts; generateObject(); break;
+        case 'a': case 'A': arcLengthSampling=!arcLengthSampling; generateObject(); break;
         case 'x': angleX+=5.0f; break;
         case 'X': angleX-=5.0f; break;
         case 'y': angleY+=5.0f; break;
@@ -304,6 +487,7 @@ void keyboard(unsigned char key,int x,int y){
 
 void mouseButton(int button,int state,int x,int y){
     if(button==GLUT_LEFT_BUTTON){ mouseLeftDown=(state==GLUT_DOWN); lastMouseX=x; lastMouseY=y; }
+    if(button==GLUT_RIGHT_BUTTON && state==GLUT_DOWN) pick(x,y);
     if(button==3){ camDist-=0.5f; if(camDist<2.0f) camDist=2.0f; }
     if(button==4){ camDist+=0.5f; if(camDist>20.0f) camDist=20.0f; }
 }
@@ -317,7 +501,286 @@ void mouseMotion(int x,int y){
     }
 }
 
+// --- Benchmarks ---
+double elapsedMs(std::chrono::steady_clock::time_point t0){
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count();
+}
+
+void benchPick(){
+    int sizes[] = {100, 300, 1000};
+    for(int s=0;s<3;s++){
+        genSphere(1.0f,sizes[s],sizes[s]);
+        auto t0=std::chrono::steady_clock::now();
+        g_bvh.build(g_vertices,g_indices);
+        double buildMs=elapsedMs(t0);
+
+        const int N=200000;
+        std::vector<Ray> rays(N); std::vector<float> pts(N*3);
+        unsigned int seed=12345;
+        auto rnd=[&](){ seed=seed*1664525u+1013904223u; return (seed>>8)*(1.0f/16777216.0f)*2.0f-1.0f; };
+        for(int i=0;i<N;i++){
+            Ray& r=rays[i];
+            r.o[0]=rnd()*3; r.o[1]=rnd()*3; r.o[2]=3.0f;
+            r.d[0]=-r.o[0]*0.3f+rnd()*0.2f; r.d[1]=-r.o[1]*0.3f+rnd()*0.2f; r.d[2]=-1.0f;
+            // closest-point queries from a shell around the surface (snap-to-mesh)
+            float q[3]={rnd(),rnd(),rnd()}, len=sqrtf(q[0]*q[0]+q[1]*q[1]+q[2]*q[2])+1e-6f, rad=1.0f+0.1f*rnd();
+            for(int k=0;k<3;k++) pts[i*3+k]=q[k]/len*rad;
+        }
+        std::vector<RayHit> hits; std::vector<ClosestHit> cl;
+        t0=std::chrono::steady_clock::now(); intersectBatch(g_bvh,rays,hits,1); double ray1=elapsedMs(t0);
+        t0=std::chrono::steady_clock::now(); intersectBatch(g_bvh,rays,hits,0); double rayN=elapsedMs(t0);
+        t0=std::chrono::steady_clock::now(); closestBatch(g_bvh,pts,cl,1); double cp1=elapsedMs(t0);
+        t0=std::chrono::steady_clock::now(); closestBatch(g_bvh,pts,cl,0); double cpN=elapsedMs(t0);
+        int nhit=0; for(int i=0;i<N;i++) nhit+=hits[i].tri>=0;
+        printf("sphere %dx%d: %zu tris, %zu nodes, build %.2f ms\n",sizes[s],sizes[s],g_bvh.triCount(),g_bvh.nodeCount(),buildMs);
+        printf("  rays:    %.2f Mq/s (1 thread), %.2f Mq/s (%u threads), %d hits\n",N/ray1/1e3,N/rayN/1e3,std::thread::hardware_concurrency(),nhit);
+        printf("  closest: %.2f Mq/s (1 thread), %.2f Mq/s (%u threads)\n",N/cp1/1e3,N/cpN/1e3,std::thread::hardware_concurrency());
+    }
+}
+
+// Runs `gen` until ~200 ms have passed; returns microseconds per call.
+template<class F> double timeCall(F gen){
+    int iters=0; auto t0=std::chrono::steady_clock::now(); double ms=0;
+    do { for(int i=0;i<16;i++) gen(); iters+=16; ms=elapsedMs(t0); } while(ms<200.0);
+    return ms*1000.0/iters;
+}
+
+// Compares the current g_vertices/g_indices (or g_curve) with a fixedgen result.
+template<class Gen,class Fixed> void compareFixed(const char* name,Gen gen,Fixed fixed,bool curve=false){
+    std::vector<float> v; std::vector<unsigned int> idx;
+    gen(); fixed(v,idx);
+    const std::vector<float>& ref = curve ? g_curve : g_vertices;
+    float err=0; for(size_t i=0;i<v.size() && i<ref.size();i++) err=std::max(err,fabsf(v[i]-ref[i]));
+    bool same = v.size()==ref.size() && (curve || idx==g_indices);
+    double rt=timeCall(gen), ft=timeCall([&](){ fixed(v,idx); });
+    printf("%-18s runtime %8.2f us  fixed %8.2f us  x%.2f  %s max err %.2g\n",name,rt,ft,rt/ft,same?"match":"MISMATCH",err);
+}
+
+void benchFixed(){
+    prepareCurveControl(); prepareSurfControl();
+    compareFixed("cylinder",[](){ genCylinder(cylRadius,cylHeight,cylSlices); },[](std::vector<float>& v,std::vector<unsigned int>& i){ fixedgen::cylinder<cylSlices>(cylRadius,cylHeight,v,i); });
+    compareFixed("cone",[](){ genCone(coneRadius,coneHeight,coneSlices); },[](std::vector<float>& v,std::vector<unsigned int>& i){ fixedgen::cone<coneSlices>(coneRadius,coneHeight,v,i); });
+    compareFixed("sphere",[](){ genSphere(sphereRadius,sphereStacks,sphereSlices); },[](std::vector<float>& v,std::vector<unsigned int>& i){ fixedgen::sphere<sphereStacks,sphereSlices>(sphereRadius,v,i); });
+    compareFixed("torus",[](){ genTorus(torusR,torusr,torusNS,torusNT); },[](std::vector<float>& v,std::vector<unsigned int>& i){ fixedgen::torus<torusNS,torusNT>(torusR,torusr,v,i); });
+    compareFixed("bezierSurface",[](){ genBezierSurface(surfRes); },[](std::vector<float>& v,std::vector<unsigned int>& i){ fixedgen::bezierSurface<surfRes>(surfP,v,i); });
+    compareFixed("bezierCurve",[](){ genBezierCurve(curveSegments); },[](std::vector<float>& v,std::vector<unsigned int>&){ fixedgen::bezierCurve<curveSegments>(bezP,v); },true);
+}
+
+void benchArcLength(){
+    prepareCurveControl();
+    float deg7[8][3];
+    for(int i=0;i<8;i++){ deg7[i][0]=i-3.5f; deg7[i][1]=(i%2?1.5f:-1.0f)*(1+i%3); deg7[i][2]=0.3f*i*i/8; }
+    struct { const char* name; const float* pts; int count; } curves[] = { {"cubic",&bezP[0][0],4}, {"degree 7",&deg7[0][0],8} };
+    int sizes[] = {1000, 10000, 100000, 1000000};
+    for(int ci=0;ci<2;ci++){
+        BezierCurve c(curves[ci].pts,curves[ci].count);
+        for(int si=0;si<4;si++){
+            ArcLengthTable table;
+            auto t0=std::chrono::steady_clock::now();
+            table.build(c,sizes[si]);
+            double buildMs=elapsedMs(t0);
+
+            const int N=1000000;
+            std::vector<double> s(N);
+            unsigned int seed=99;
+            for(int i=0;i<N;i++){ seed=seed*1664525u+1013904223u; s[i]=table.length()*(seed>>8)/16777216.0; }
+            double sink=0, rate[2];
+            for(int newton=0;newton<2;newton++){
+                t0=std::chrono::steady_clock::now();
+                for(int i=0;i<N;i++) sink+=table.tAtLength(s[i],newton);
+                rate[newton]=N/elapsedMs(t0)/1e3;
+            }
+
+            // lookup accuracy: re-integrate 0..t at tight tolerance and compare with the requested distance
+            double err=0;
+            for(int i=0;i<N;i+=N/200){
+                double t=table.tAtLength(s[i]);
+                err=std::max(err,fabs(adaptiveLength(c,0,t,gaussLegendre5(c,0,t),1e-13)-s[i]));
+            }
+            printf("%-8s %7d segs: length %.6f, build %8.2f ms, %5.1f MB, lookup %.2f Mq/s (table) %.2f Mq/s (+newton), max err %.1e%s\n",
+                curves[ci].name,sizes[si],table.length(),buildMs,table.bytes()/1048576.0,rate[0],rate[1],err,sink<0?"!":"");
+        }
+    }
+}
+
+// --- Batch generation ---
+// Largest mesh a job may produce: the generators index vertices with int
+// arithmetic and store unsigned int indices.
+const double MAX_JOB_VERTICES = 2147483647.0;
+
+// Tessellates one manifest job on the calling thread; the mesh is left in g_vertices/g_indices.
+// Returns false for an unknown type or out-of-range parameters.
+bool runJob(const BatchJob& job){
+    const std::vector<double>& a=job.args;
+    size_t n=a.size();
+    for(size_t i=0;i<n;i++) if(!std::isfinite(a[i]) || fabs(a[i])>1e30) return false;
+    // resolution arguments must be whole numbers in [lo, 2^24] before the int cast
+    auto res=[&](size_t i,int lo){ return a[i]>=lo && a[i]<=16777216.0 && a[i]==floor(a[i]); };
+    auto fits=[&](double verts){ return verts<=MAX_JOB_VERTICES; };
+    auto count=[&](size_t i){ return (int)a[i]; };
+    if(job.type=="cylinder" && n==3 && res(2,3) && fits((a[2]+1)*2+2)) genCylinder(a[0],a[1],count(2));
+    else if(job.type=="cone" && n==3 && res(2,3) && fits(a[2]+3)) genCone(a[0],a[1],count(2));
+    else if(job.type=="sphere" && n==3 && res(1,1) && res(2,3) && fits((a[1]+1)*(a[2]+1))) genSphere(a[0],count(1),count(2));
+    else if(job.type=="torus" && n==4 && res(2,3) && res(3,3) && fits((a[2]+1)*(a[3]+1))) genTorus(a[0],a[1],count(2),count(3));
+    else if(job.type=="bezier_curve" && (n==1 || n==13) && res(0,1)){
+        prepareCurveControl();
+        for(size_t i=1;i<n;i++) bezP[(i-1)/3][(i-1)%3]=a[i];
+        g_vertices.clear(); g_indices.clear();
+        genBezierCurve(count(0));
+        g_vertices.swap(g_curve);
+    }
+    else if(job.type=="bezier_surface" && (n==1 || n==49) && res(0,1) && fits((a[0]+1)*(a[0]+1))){
+        prepareSurfControl();
+        for(size_t i=1;i<n;i++) surfP[(i-1)/12][(i-1)/3%4][(i-1)%3]=a[i];
+        genBezierSurface(count(0));
+    }
+    else return false;
+    return true;
+}
+
+int runBatch(const char* manifest,const char* outPrefix,unsigned threads){
+    std::vector<BatchJob> jobs;
+    if(!parseManifest(manifest,jobs)) return 1;
+    MeshStore store;
+    if(!store.open(outPrefix)) return 1;
+    if(threads==0) threads=std::max(1u,std::thread::hardware_concurrency());
+
+    std::vector<double> latency(jobs.size(),0.0);
+    std::atomic<size_t> next(0), failed(0);
+    auto t0=std::chrono::steady_clock::now();
+    auto worker=[&](){
+        for(size_t i=next++;i<jobs.size();i=next++){
+            auto tj=std::chrono::steady_clock::now();
+            // an exception escaping a std::thread would terminate the whole run
+            try {
+                if(!runJob(jobs[i])){ fprintf(stderr,"job %s: bad type or parameters\n",jobs[i].id.c_str()); failed++; continue; }
+                latency[i]=elapsedMs(tj);
+                if(!store.write(jobs[i],g_vertices,g_indices)){ failed++; latency[i]=0; }
+            } catch(const std::exception& e){
+                fprintf(stderr,"job %s: %s\n",jobs[i].id.c_str(),e.what());
+                failed++; latency[i]=0;
+                std::vector<float>().swap(g_vertices); std::vector<unsigned int>().swap(g_indices); std::vector<float>().swap(g_curve);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for(unsigned t=0;t<threads;t++) pool.emplace_back(worker);
+    for(size_t t=0;t<pool.size();t++) pool[t].join();
+    double wallMs=elapsedMs(t0);
+    bool written=store.close();
+
+    size_t done=jobs.size()-failed;
+    std::vector<double> sorted; sorted.reserve(done);
+    for(size_t i=0;i<jobs.size();i++) if(latency[i]>0) sorted.push_back(latency[i]);
+    std::sort(sorted.begin(),sorted.end());
+    printf("%zu jobs (%zu failed) on %u threads in %.1f ms: %.1f jobs/s, %.1f MB written\n",
+        jobs.size(),(size_t)failed,threads,wallMs,done*1000.0/wallMs,store.bytes()/1048576.0);
+    printf("per-job tessellation ms: p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+        percentile(sorted,0.5),percentile(sorted,0.9),percentile(sorted,0.99),sorted.empty()?0.0:sorted.back());
+    if(!written){ fprintf(stderr,"write to %s.bin/.idx failed; output is incomplete\n",outPrefix); return 1; }
+    return failed ? 2 : 0;
+}
+
+// Random manifest of `n` jobs for sizing runs.
+int makeManifest(int n,const char* path){
+    FILE* f=fopen(path,"w");
+    if(!f){ fprintf(stderr,"cannot write %s\n",path); return 1; }
+    unsigned int seed=777;
+    auto rnd=[&](int lo,int hi){ seed=seed*1664525u+1013904223u; return lo+(int)((seed>>8)%(unsigned)(hi-lo+1)); };
+    for(int i=0;i<n;i++){
+        switch(rnd(0,5)){
+            case 0: fprintf(f,"part%06d,cylinder,%d,%d,%d\n",i,rnd(1,5),rnd(1,10),rnd(8,256)); break;
+            case 1: fprintf(f,"part%06d,cone,%d,%d,%d\n",i,rnd(1,5),rnd(1,10),rnd(8,256)); break;
+            case 2: fprintf(f,"part%06d,sphere,%d,%d,%d\n",i,rnd(1,5),rnd(8,128),rnd(8,128)); break;
+            case 3: fprintf(f,"part%06d,torus,%d,0.%d,%d,%d\n",i,rnd(2,5),rnd(1,9),rnd(8,128),rnd(8,64)); break;
+            case 4: fprintf(f,"part%06d,bezier_curve,%d\n",i,rnd(16,1000)); break;
+            default: fprintf(f,"part%06d,bezier_surface,%d\n",i,rnd(8,100)); break;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+#ifdef LAB_HEADLESS
+// Turntable sweep of each object in `objs` ("1,3,4"), written as outDir/obj<N>_<frame>.ppm.
+int runHeadless(const char* objs,int frames,const char* outDir,int size){
+    auto t0=std::chrono::steady_clock::now();
+    HeadlessGL gl;
+    if(!gl.init(size,size)){ gl.shutdown(); return 1; }
+    double initMs=elapsedMs(t0);
+    printf("headless: %s, %dx%d\n",(const char*)glGetString(GL_RENDERER),size,size);
+
+    glEnable(GL_DEPTH_TEST); glEnable(GL_NORMALIZE); glShadeModel(GL_SMOOTH);
+    glClearColor(0.12f,0.12f,0.12f,1.0f);
+    reshape(size,size);
+    prepareSurfControl();
+
+    std::vector<unsigned char> rgb;
+    double renderMs=0, writeMs=0; int total=0;
+    for(const char* p=objs;*p;p++){
+        if(*p<'1' || *p>'6') continue;
+        currentObj=*p-'0'; generateObject();
+        angleX=angleZ=0.0f;
+        for(int f=0;f<frames;f++){
+            angleY=360.0f*f/frames;
+            auto tr=std::chrono::steady_clock::now();
+            renderScene();
+            gl.readPixels(rgb);
+            renderMs+=elapsedMs(tr);
+            auto tw=std::chrono::steady_clock::now();
+            char path[512]; snprintf(path,sizeof(path),"%s/obj%d_%04d.ppm",outDir,currentObj,f);
+            if(!writePPM(path,size,size,rgb)){ gl.shutdown(); return 1; }
+            writeMs+=elapsedMs(tw);
+            total++;
+        }
+    }
+    gl.shutdown();
+    double wallMs=elapsedMs(t0);
+    printf("%d frames: render+readback %.1f ms (%.1f fps), write %.1f ms, context %.1f ms, wall %.1f ms (%.1f fps)\n",
+        total,renderMs,total*1000.0/renderMs,writeMs,initMs,wallMs,total*1000.0/wallMs);
+    return 0;
+}
+#endif
+
 int main(int argc,char** argv){
+    if(argc>1 && !strcmp(argv[1],"--bench-pick")){ benchPick(); return 0; }
+    if(argc>1 && !strcmp(argv[1],"--bench-fixed")){ benchFixed(); return 0; }
+#ifdef LAB_HEADLESS
+    if(argc>1 && !strcmp(argv[1],"--headless")){
+        if(argc<5){ printf("usage: %s --headless <objects e.g. 1,3,6> <frames> <outdir> [size=512] [compact]\n",argv[0]); return 1; }
+        int frames=atoi(argv[3]), size=argc>5?atoi(argv[5]):512;
+        if(frames<1 || size<1){ fprintf(stderr,"frames and size must be positive\n"); return 1; }
+        compactVerts = argc>6 && !strcmp(argv[6],"compact");
+        return runHeadless(argv[2],frames,argv[4],size);
+    }
+#else
+    if(argc>1 && !strcmp(argv[1],"--headless")){ fprintf(stderr,"built without headless support; rebuild with -DLAB_HEADLESS -lEGL\n"); return 1; }
+#endif
+    if(argc>1 && !strcmp(argv[1],"--bench-arclen")){ benchArcLength(); return 0; }
+    if(argc>1 && !strcmp(argv[1],"--batch")){
+        if(argc<4){ printf("usage: %s --batch <manifest.csv> <out prefix> [threads]\n",argv[0]); return 1; }
+        unsigned threads=0;   // default: one per core
+        if(argc>4){
+            char* end; long t=strtol(argv[4],&end,10);
+            if(*end || t<1 || t>1024){ fprintf(stderr,"threads must be between 1 and 1024\n"); return 1; }
+            threads=(unsigned)t;
+        }
+        return runBatch(argv[2],argv[3],threads);
+    }
+    if(argc>1 && !strcmp(argv[1],"--make-manifest")){
+        if(argc<4){ printf("usage: %s --make-manifest <jobs> <manifest.csv>\n",argv[0]); return 1; }
+        return makeManifest(atoi(argv[2]),argv[3]);
+    }
+    if(argc>1 && !strcmp(argv[1],"--compact-report")){
+        compactVerts=true; prepareSurfControl();
+        const char* names[]={"","cylinder","cone","sphere","torus","bezier curve","bezier surface"};
+        for(currentObj=OBJ_CYLINDER;currentObj<=OBJ_BEZIER_SURF;currentObj++){
+            if(currentObj==OBJ_BEZIER_CURVE) continue;
+            printf("%-15s ",names[currentObj]); generateObject();
+        }
+        return 0;
+    }
+
     glutInit(&argc,argv);
     glutInitDisplayMode(GLUT_DOUBLE|GLUT_RGBA|GLUT_DEPTH);
     glutInitWindowSize(600,600);
@@ -335,7 +798,7 @@ int main(int argc,char** argv){
 
     glClearColor(0.12f,0.12f,0.12f,1.0f);
 
-    printf("Controls:\n 1..6: select object\n W: wireframe toggle\n X/x,Y/y,Z/z: rotate\nMouse drag: rotate\nScroll: zoom\nESC: exit\n");
+    printf("Controls:\n 1..6: select object\n W: wireframe toggle\n C: compact vertex format toggle\n A: arc-length curve sampling toggle\n X/x,Y/y,Z/z: rotate\nMouse drag: rotate\nRight click: pick\nScroll: zoom\nESC: exit\n");
 
     glutMainLoop();
     return 0;
@@ -0,0 +1,71 @@
+#pragma once
+// Compact vertex layout, 16 bytes: GL_SHORT positions relative to the mesh bounds,
+// GL_SHORT normals and GL_SHORT UVs (2*uv-1, so [0,1] uses the full signed range).
+// Every component is something fixed-function vertex arrays accept directly, so
+// drawing decodes on the GL side: positions via a translate/scale on the modelview,
+// UVs via a scale/offset on the texture matrix, normals by GL's signed-integer
+// normalization plus GL_NORMALIZE.
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+struct PackedVertex { int16_t p[3]; int16_t n[3]; int16_t uv[2]; };
+
+inline int16_t quantSnorm16(float x){ x=std::min(1.0f,std::max(-1.0f,x)); return (int16_t)lrintf(x*32767.0f); }
+
+struct PackedMesh {
+    float center[3], half[3];   // position = center + p/32767 * half
+    std::vector<PackedVertex> v;
+    float maxPosErr, maxNrmErrDeg, maxUvErr;   // measured while encoding
+
+    // Bounds must enclose every position added afterwards.
+    void begin(const float* lo,const float* hi){
+        v.clear(); maxPosErr=maxNrmErrDeg=maxUvErr=0.0f;
+        float big=0;
+        for(int k=0;k<3;k++){ center[k]=0.5f*(lo[k]+hi[k]); half[k]=0.5f*(hi[k]-lo[k]); big=std::max(big,half[k]); }
+        // a flat axis still needs a usable scale for the normal pre-scaling in add()
+        for(int k=0;k<3;k++) half[k]=std::max(half[k],std::max(big*1e-4f,1e-20f));
+    }
+
+    void add(float x,float y,float z,float nx,float ny,float nz,float s,float t){
+        PackedVertex pv; float p[3]={x,y,z}, n[3]={nx,ny,nz}, uv[2]={s,t};
+        for(int k=0;k<3;k++) pv.p[k]=quantSnorm16((p[k]-center[k])/half[k]);
+        float l=sqrtf(nx*nx+ny*ny+nz*nz);
+        if(l>0){ for(int k=0;k<3;k++) n[k]/=l; } else { n[0]=0; n[1]=0; n[2]=1; }
+        // GL transforms normals by the inverse transpose of the bounds scale, so store
+        // them pre-multiplied by that scale; GL_NORMALIZE restores unit length.
+        float sn[3]={n[0]*half[0],n[1]*half[1],n[2]*half[2]};
+        float sl=sqrtf(sn[0]*sn[0]+sn[1]*sn[1]+sn[2]*sn[2]);
+        for(int k=0;k<3;k++) pv.n[k]=quantSnorm16(sn[k]/sl);
+        pv.uv[0]=quantSnorm16(2.0f*s-1.0f); pv.uv[1]=quantSnorm16(2.0f*t-1.0f);
+        v.push_back(pv);
+
+        float dp[3],dn[3],duv[2];
+        decode(v.size()-1,dp,dn,duv);
+        for(int k=0;k<3;k++) maxPosErr=std::max(maxPosErr,fabsf(dp[k]-p[k]));
+        float c=std::min(1.0f,n[0]*dn[0]+n[1]*dn[1]+n[2]*dn[2]);
+        maxNrmErrDeg=std::max(maxNrmErrDeg,acosf(c)*57.2957795f);
+        for(int k=0;k<2;k++) maxUvErr=std::max(maxUvErr,fabsf(duv[k]-uv[k]));
+    }
+
+    // CPU reference of what GL computes from the arrays.
+    void decode(size_t i,float* pos,float* nrm,float* uv) const {
+        const PackedVertex& pv=v[i];
+        for(int k=0;k<3;k++) pos[k]=center[k]+pv.p[k]*(1.0f/32767.0f)*half[k];
+        float l=0;
+        for(int k=0;k<3;k++){ nrm[k]=pv.n[k]/half[k]; l+=nrm[k]*nrm[k]; }
+        l=l>0?1.0f/sqrtf(l):0.0f;
+        for(int k=0;k<3;k++) nrm[k]*=l;
+        uv[0]=pv.uv[0]*(0.5f/32767.0f)+0.5f; uv[1]=pv.uv[1]*(0.5f/32767.0f)+0.5f;
+    }
+
+    // xyz floats, e.g. for building a pick index
+    void decodePositions(std::vector<float>& out) const {
+        out.resize(v.size()*3);
+        for(size_t i=0;i<v.size();i++)
+            for(int k=0;k<3;k++) out[i*3+k]=center[k]+v[i].p[k]*(1.0f/32767.0f)*half[k];
+    }
+
+    size_t bytes() const { return v.size()*sizeof(PackedVertex); }
+};
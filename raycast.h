@@ -0,0 +1,357 @@
+#pragma once
+// Ray queries against the generated meshes: a BVH over the triangles in
+// g_vertices/g_indices layout and a small index over control points.
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+struct Ray { float o[3], d[3]; };
+struct RayHit { float t, u, v; int tri; };            // tri<0: miss
+struct ClosestHit { float p[3]; float d2; int tri; };  // tri<0: empty mesh
+
+// Flat node array: left child is node+1, right child is `right`. Leaf when count>0.
+struct BVHNode { float mn[3], mx[3]; int first, count, right; };
+
+inline float dot3(const float* a,const float* b){ return a[0]*b[0]+a[1]*b[1]+a[2]*b[2]; }
+inline void sub3(float* r,const float* a,const float* b){ r[0]=a[0]-b[0]; r[1]=a[1]-b[1]; r[2]=a[2]-b[2]; }
+inline void cross3(float* r,const float* a,const float* b){ r[0]=a[1]*b[2]-a[2]*b[1]; r[1]=a[2]*b[0]-a[0]*b[2]; r[2]=a[0]*b[1]-a[1]*b[0]; }
+
+// Slab test; returns entry distance or FLT_MAX on miss.
+inline float rayBox(const BVHNode& n,const float* o,const float* inv,float tMax){
+    float t0=0.0f,t1=tMax;
+    for(int k=0;k<3;k++){
+        float a=(n.mn[k]-o[k])*inv[k], b=(n.mx[k]-o[k])*inv[k];
+        if(a>b) std::swap(a,b);
+        t0=a>t0?a:t0; t1=b<t1?b:t1;
+        if(t0>t1) return FLT_MAX;
+    }
+    return t0;
+}
+
+inline float boxDist2(const BVHNode& n,const float* p){
+    float d2=0.0f;
+    for(int k=0;k<3;k++){
+        float d=0.0f;
+        if(p[k]<n.mn[k]) d=n.mn[k]-p[k]; else if(p[k]>n.mx[k]) d=p[k]-n.mx[k];
+        d2+=d*d;
+    }
+    return d2;
+}
+
+inline void invDir(const Ray& r,float* inv){
+    for(int k=0;k<3;k++) inv[k]=1.0f/(fabsf(r.d[k])>1e-12f?r.d[k]:(r.d[k]<0?-1e-12f:1e-12f));
+}
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5).
+inline void closestOnTri(const float* p,const float* a,const float* b,const float* c,float* out){
+    float ab[3],ac[3],ap[3]; sub3(ab,b,a); sub3(ac,c,a); sub3(ap,p,a);
+    float d1=dot3(ab,ap), d2=dot3(ac,ap);
+    if(d1<=0 && d2<=0){ out[0]=a[0]; out[1]=a[1]; out[2]=a[2]; return; }
+    float bp[3]; sub3(bp,p,b);
+    float d3=dot3(ab,bp), d4=dot3(ac,bp);
+    if(d3>=0 && d4<=d3){ out[0]=b[0]; out[1]=b[1]; out[2]=b[2]; return; }
+    float vc=d1*d4-d3*d2;
+    if(vc<=0 && d1>=0 && d3<=0){ float v=d1/(d1-d3); for(int k=0;k<3;k++) out[k]=a[k]+v*ab[k]; return; }
+    float cp[3]; sub3(cp,p,c);
+    float d5=dot3(ab,cp), d6=dot3(ac,cp);
+    if(d6>=0 && d5<=d6){ out[0]=c[0]; out[1]=c[1]; out[2]=c[2]; return; }
+    float vb=d5*d2-d1*d6;
+    if(vb<=0 && d2>=0 && d6<=0){ float w=d2/(d2-d6); for(int k=0;k<3;k++) out[k]=a[k]+w*ac[k]; return; }
+    float va=d3*d6-d5*d4;
+    if(va<=0 && (d4-d3)>=0 && (d5-d6)>=0){
+        float w=(d4-d3)/((d4-d3)+(d5-d6));
+        for(int k=0;k<3;k++) out[k]=b[k]+w*(c[k]-b[k]);
+        return;
+    }
+    float den=1.0f/(va+vb+vc), v=vb*den, w=vc*den;
+    for(int k=0;k<3;k++) out[k]=a[k]+ab[k]*v+ac[k]*w;
+}
+
+// --- Triangle BVH (binned SAH) ---
+class TriBVH {
+public:
+    void build(const std::vector<float>& verts,const std::vector<unsigned int>& idx){
+        nodes.clear(); ids.clear(); tv.clear();
+        int n=(int)(idx.size()/3);
+        if(n==0) return;
+        box.resize(n*6); cen.resize(n*3); ids.resize(n);
+        for(int i=0;i<n;i++){
+            ids[i]=i;
+            const float* a=&verts[idx[i*3]*3]; const float* b=&verts[idx[i*3+1]*3]; const float* c=&verts[idx[i*3+2]*3];
+            for(int k=0;k<3;k++){
+                box[i*6+k]=std::min(a[k],std::min(b[k],c[k]));
+                box[i*6+3+k]=std::max(a[k],std::max(b[k],c[k]));
+                cen[i*3+k]=(a[k]+b[k]+c[k])*(1.0f/3.0f);
+            }
+        }
+        nodes.reserve(2*n/LEAF+1);
+        buildNode(0,n);
+        // copy triangle corners in leaf order so traversal reads them contiguously
+        tv.resize(n*9);
+        for(int i=0;i<n;i++)
+            for(int c=0;c<3;c++)
+                for(int k=0;k<3;k++) tv[i*9+c*3+k]=verts[idx[ids[i]*3+c]*3+k];
+        box.clear(); box.shrink_to_fit(); cen.clear(); cen.shrink_to_fit();
+    }
+
+    bool intersect(const Ray& r,RayHit& h,float tMax=FLT_MAX) const {
+        h.tri=-1; h.t=tMax;
+        if(nodes.empty()) return false;
+        float inv[3]; invDir(r,inv);
+        int stack[64], sp=0, node=0;
+        if(rayBox(nodes[0],r.o,inv,h.t)==FLT_MAX) return false;
+        for(;;){
+            const BVHNode& n=nodes[node];
+            if(n.count>0){
+                for(int i=n.first;i<n.first+n.count;i++) hitTri(r,i,h);
+                if(sp==0) break;
+                node=stack[--sp]; continue;
+            }
+            int l=node+1, rr=n.right;
+            float tl=rayBox(nodes[l],r.o,inv,h.t), tr=rayBox(nodes[rr],r.o,inv,h.t);
+            if(tl>tr){ std::swap(tl,tr); std::swap(l,rr); }
+            if(tl==FLT_MAX){ if(sp==0) break; node=stack[--sp]; continue; }
+            if(tr!=FLT_MAX) stack[sp++]=rr;
+            node=l;
+        }
+        return h.tri>=0;
+    }
+
+    bool closest(const float* p,ClosestHit& c) const {
+        c.tri=-1; c.d2=FLT_MAX;
+        if(nodes.empty()) return false;
+        int stack[64], sp=0, node=0;
+        for(;;){
+            const BVHNode& n=nodes[node];
+            if(n.count>0){
+                for(int i=n.first;i<n.first+n.count;i++){
+                    float q[3]; closestOnTri(p,&tv[i*9],&tv[i*9+3],&tv[i*9+6],q);
+                    float d[3]; sub3(d,q,p); float d2=dot3(d,d);
+                    if(d2<c.d2){ c.d2=d2; c.tri=ids[i]; c.p[0]=q[0]; c.p[1]=q[1]; c.p[2]=q[2]; }
+                }
+            } else {
+                int l=node+1, rr=n.right;
+                float dl=boxDist2(nodes[l],p), dr=boxDist2(nodes[rr],p);
+                if(dl>dr){ std::swap(dl,dr); std::swap(l,rr); }
+                if(dr<c.d2) stack[sp++]=rr;
+                if(dl<c.d2){ node=l; continue; }
+            }
+            // pop, skipping nodes that became too far since they were pushed
+            while(sp>0 && boxDist2(nodes[stack[sp-1]],p)>=c.d2) sp--;
+            if(sp==0) break;
+            node=stack[--sp];
+        }
+        return c.tri>=0;
+    }
+
+    size_t triCount() const { return ids.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    enum { LEAF=4, BINS=16 };
+    std::vector<BVHNode> nodes;
+    std::vector<int> ids;      // leaf order -> original triangle index
+    std::vector<float> tv;     // 9 floats per triangle, leaf order
+    std::vector<float> box, cen;
+
+    void hitTri(const Ray& r,int i,RayHit& h) const {
+        // Moller-Trumbore
+        const float* a=&tv[i*9]; const float* b=a+3; const float* c=a+6;
+        float e1[3],e2[3],pv[3],tvec[3],qv[3];
+        sub3(e1,b,a); sub3(e2,c,a); cross3(pv,r.d,e2);
+        float det=dot3(e1,pv);
+        if(fabsf(det)<1e-12f) return;
+        float id=1.0f/det;
+        sub3(tvec,r.o,a);
+        float u=dot3(tvec,pv)*id; if(u<0.0f||u>1.0f) return;
+        cross3(qv,tvec,e1);
+        float v=dot3(r.d,qv)*id; if(v<0.0f||u+v>1.0f) return;
+        float t=dot3(e2,qv)*id;
+        if(t>1e-6f && t<h.t){ h.t=t; h.u=u; h.v=v; h.tri=ids[i]; }
+    }
+
+    void bounds(int first,int count,BVHNode& n,float* cmn,float* cmx) const {
+        for(int k=0;k<3;k++){ n.mn[k]=cmn[k]=FLT_MAX; n.mx[k]=cmx[k]=-FLT_MAX; }
+        for(int i=first;i<first+count;i++){
+            const float* b=&box[ids[i]*6]; const float* c=&cen[ids[i]*3];
+            for(int k=0;k<3;k++){
+                n.mn[k]=std::min(n.mn[k],b[k]); n.mx[k]=std::max(n.mx[k],b[3+k]);
+                cmn[k]=std::min(cmn[k],c[k]); cmx[k]=std::max(cmx[k],c[k]);
+            }
+        }
+    }
+
+    static float area(const float* mn,const float* mx){
+        float dx=mx[0]-mn[0], dy=mx[1]-mn[1], dz=mx[2]-mn[2];
+        return dx*dy+dy*dz+dz*dx;
+    }
+
+    int buildNode(int first,int count){
+        int me=(int)nodes.size();
+        nodes.push_back(BVHNode());
+        float cmn[3],cmx[3];
+        bounds(first,count,nodes[me],cmn,cmx);
+        nodes[me].first=first; nodes[me].count=count; nodes[me].right=-1;
+        if(count<=LEAF) return me;
+
+        int axis=0;
+        for(int k=1;k<3;k++) if(cmx[k]-cmn[k]>cmx[axis]-cmn[axis]) axis=k;
+        float ext=cmx[axis]-cmn[axis];
+        int mid=first+count/2;
+        if(ext>1e-12f){
+            // binned SAH along the widest centroid axis
+            int bc[BINS]={0}; float bmn[BINS][3],bmx[BINS][3];
+            for(int b=0;b<BINS;b++) for(int k=0;k<3;k++){ bmn[b][k]=FLT_MAX; bmx[b][k]=-FLT_MAX; }
+            float scale=BINS/ext;
+            for(int i=first;i<first+count;i++){
+                int b=std::min(BINS-1,(int)((cen[ids[i]*3+axis]-cmn[axis])*scale));
+                bc[b]++;
+                const float* bx=&box[ids[i]*6];
+                for(int k=0;k<3;k++){ bmn[b][k]=std::min(bmn[b][k],bx[k]); bmx[b][k]=std::max(bmx[b][k],bx[3+k]); }
+            }
+            float rA[BINS]; int rN[BINS];
+            float mn[3]={FLT_MAX,FLT_MAX,FLT_MAX}, mx[3]={-FLT_MAX,-FLT_MAX,-FLT_MAX}; int cnt=0;
+            for(int b=BINS-1;b>0;b--){
+                cnt+=bc[b];
+                for(int k=0;k<3;k++){ mn[k]=std::min(mn[k],bmn[b][k]); mx[k]=std::max(mx[k],bmx[b][k]); }
+                rA[b]=cnt?area(mn,mx):0.0f; rN[b]=cnt;
+            }
+            for(int k=0;k<3;k++){ mn[k]=FLT_MAX; mx[k]=-FLT_MAX; }
+            cnt=0; int best=-1; float bestCost=FLT_MAX;
+            for(int b=0;b<BINS-1;b++){
+                cnt+=bc[b];
+                for(int k=0;k<3;k++){ mn[k]=std::min(mn[k],bmn[b][k]); mx[k]=std::max(mx[k],bmx[b][k]); }
+                if(cnt==0 || rN[b+1]==0) continue;
+                float cost=cnt*area(mn,mx)+rN[b+1]*rA[b+1];
+                if(cost<bestCost){ bestCost=cost; best=b; }
+            }
+            if(best>=0){
+                int* p=std::partition(&ids[first],&ids[first]+count,[&](int t){
+                    return std::min(BINS-1,(int)((cen[t*3+axis]-cmn[axis])*scale))<=best; });
+                mid=(int)(p-&ids[0]);
+            }
+        }
+        if(mid==first || mid==first+count){
+            mid=first+count/2;
+            std::nth_element(&ids[first],&ids[mid],&ids[first]+count,[&](int a,int b){ return cen[a*3+axis]<cen[b*3+axis]; });
+        }
+        nodes[me].count=0;
+        buildNode(first,mid-first);
+        int r=buildNode(mid,first+count-mid);
+        nodes[me].right=r;
+        return me;
+    }
+};
+
+// --- Control point index: median-split tree over a handful of xyz points ---
+class PointIndex {
+public:
+    void build(const float* pts,int n){
+        p.assign(pts,pts+n*3); nodes.clear(); ids.resize(n);
+        for(int i=0;i<n;i++) ids[i]=i;
+        if(n>0) buildNode(0,n);
+    }
+
+    // Point closest to the ray origin among those within `radius` of the ray; -1 if none.
+    int pickRay(const Ray& r,float radius,float* tOut=0) const {
+        if(nodes.empty()) return -1;
+        float inv[3]; invDir(r,inv);
+        float dd=dot3(r.d,r.d), r2=radius*radius;
+        int best=-1; float bestT=FLT_MAX;
+        int stack[64], sp=0; stack[sp++]=0;
+        while(sp>0){
+            int ni=stack[--sp];
+            BVHNode n=nodes[ni];
+            for(int k=0;k<3;k++){ n.mn[k]-=radius; n.mx[k]+=radius; }
+            if(rayBox(n,r.o,inv,bestT)==FLT_MAX) continue;
+            if(n.count==0){ stack[sp++]=n.right; stack[sp++]=ni+1; continue; }
+            for(int i=n.first;i<n.first+n.count;i++){
+                const float* q=&p[ids[i]*3];
+                float w[3]; sub3(w,q,r.o);
+                float t=dot3(w,r.d)/dd;
+                if(t<0.0f || t>=bestT) continue;
+                float c[3]={r.o[0]+t*r.d[0]-q[0], r.o[1]+t*r.d[1]-q[1], r.o[2]+t*r.d[2]-q[2]};
+                if(dot3(c,c)<=r2){ bestT=t; best=ids[i]; }
+            }
+        }
+        if(tOut) *tOut=bestT;
+        return best;
+    }
+
+    int nearest(const float* q,float* d2Out=0) const {
+        if(nodes.empty()) return -1;
+        int best=-1; float bestD2=FLT_MAX;
+        int stack[64], sp=0; stack[sp++]=0;
+        while(sp>0){
+            int ni=stack[--sp];
+            const BVHNode& n=nodes[ni];
+            if(boxDist2(n,q)>=bestD2) continue;
+            if(n.count==0){ stack[sp++]=n.right; stack[sp++]=ni+1; continue; }
+            for(int i=n.first;i<n.first+n.count;i++){
+                float d[3]; sub3(d,&p[ids[i]*3],q); float d2=dot3(d,d);
+                if(d2<bestD2){ bestD2=d2; best=ids[i]; }
+            }
+        }
+        if(d2Out) *d2Out=bestD2;
+        return best;
+    }
+
+    size_t size() const { return ids.size(); }
+
+private:
+    enum { LEAF=2 };
+    std::vector<float> p;
+    std::vector<int> ids;
+    std::vector<BVHNode> nodes;
+
+    int buildNode(int first,int count){
+        int me=(int)nodes.size();
+        nodes.push_back(BVHNode());
+        BVHNode& n=nodes[me];
+        for(int k=0;k<3;k++){ n.mn[k]=FLT_MAX; n.mx[k]=-FLT_MAX; }
+        for(int i=first;i<first+count;i++)
+            for(int k=0;k<3;k++){ n.mn[k]=std::min(n.mn[k],p[ids[i]*3+k]); n.mx[k]=std::max(n.mx[k],p[ids[i]*3+k]); }
+        n.first=first; n.count=count; n.right=-1;
+        if(count<=LEAF) return me;
+        int axis=0;
+        for(int k=1;k<3;k++) if(n.mx[k]-n.mn[k]>n.mx[axis]-n.mn[axis]) axis=k;
+        int mid=first+count/2;
+        std::nth_element(&ids[first],&ids[mid],&ids[first]+count,[&](int a,int b){ return p[a*3+axis]<p[b*3+axis]; });
+        nodes[me].count=0;
+        buildNode(first,mid-first);
+        int r=buildNode(mid,first+count-mid);
+        nodes[me].right=r;
+        return me;
+    }
+};
+
+// --- Batched queries, split across worker threads (threads=0: one per core) ---
+template<class F> void parallelRanges(size_t n,unsigned threads,F f){
+    if(threads==0) threads=std::max(1u,std::thread::hardware_concurrency());
+    if(threads<=1 || n<1024){ f(size_t(0),n); return; }
+    std::vector<std::thread> pool;
+    size_t chunk=(n+threads-1)/threads;
+    for(unsigned t=0;t<threads;t++){
+        size_t b=t*chunk, e=std::min(n,b+chunk);
+        if(b>=e) break;
+        pool.emplace_back(f,b,e);
+    }
+    for(size_t i=0;i<pool.size();i++) pool[i].join();
+}
+
+inline void intersectBatch(const TriBVH& bvh,const std::vector<Ray>& rays,std::vector<RayHit>& hits,unsigned threads=0){
+    hits.resize(rays.size());
+    parallelRanges(rays.size(),threads,[&](size_t b,size_t e){
+        for(size_t i=b;i<e;i++) bvh.intersect(rays[i],hits[i]);
+    });
+}
+
+// pts: xyz triples
+inline void closestBatch(const TriBVH& bvh,const std::vector<float>& pts,std::vector<ClosestHit>& out,unsigned threads=0){
+    out.resize(pts.size()/3);
+    parallelRanges(out.size(),threads,[&](size_t b,size_t e){
+        for(size_t i=b;i<e;i++) bvh.closest(&pts[i*3],out[i]);
+    });
+}